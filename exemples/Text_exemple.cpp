@@ -27,6 +27,9 @@ U8g2_for_TFT_eSPI u8f;
 // Vecteur pour gérer tous nos composants UI
 std::vector<std::unique_ptr<UIComponent>> components;
 
+// La ListBox est redessinée par son propre planificateur (voir loop())
+UIListBox* listBox = nullptr;
+
 // Variables pour la gestion simple du toucher
 static bool wasTouched = false;
 uint16_t touchX, touchY;
@@ -77,7 +80,12 @@ void setup() {
     // 3. Création des composants
     
     // ListBox
-    auto listBox = new UIListBox(u8f, {160, 10, 150, 220}, listBoxStyle);     
+    listBox = new UIListBox(u8f, {160, 10, 150, 220}, listBoxStyle);
+    listBox->setFrameRate(30);       // Au plus 30 images/s, les glissements intermédiaires sont fusionnés
+    listBox->setFrameBudget(8000);   // 8 ms max par image, sinon le redessin est étalé par tranches de lignes
+    listBox->onDeadlineMissed([](uint32_t us) {
+        Serial.printf("ListBox: image trop longue (%u us)\n", (unsigned)us);
+    });
     std::vector<ListBoxItem> cities;
     const char* city_names[] = {
         "Paris", "Tokyo", "New York", "London", "Berlin",
@@ -126,9 +134,11 @@ void loop() {
 
     // Redessiner les composants qui ont changé
     for (const auto& comp : components) {
-        if (comp->isDirty()) {
+        if (comp.get() == listBox) {
+            listBox->service(tft); // Cadencé et découpé par la ListBox elle-même
+        } else if (comp->isDirty()) {
             comp->draw(tft);
         }
     }
-    delay(20);
+    delay(20); // Le tactile partage souvent le bus SPI de l'écran : inutile de le scruter plus souvent
 }
\ No newline at end of file
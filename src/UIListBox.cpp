@@ -6,8 +6,28 @@ UIListBox::UIListBox(U8g2_for_TFT_eSPI& u8f, const UIRect& rect, const UIListBox
     _visibleItemCount = rect.h / _style.itemHeight;
 }
 
+void UIListBox::setStyle(const UIListBoxStyle& style) {
+    _style = style;
+    _visibleItemCount = rect.h / _style.itemHeight;
+
+    // Les métriques et largeurs dépendent de la police : tout invalider
+    _fontMetricsValid = false;
+    _textCacheMaxWidth = -1;
+
+    int maxTopIndex = _items.size() - _visibleItemCount;
+    if (maxTopIndex < 0) {
+        maxTopIndex = 0;
+    }
+    if (_topItemIndex > maxTopIndex) {
+        _topItemIndex = maxTopIndex;
+    }
+
+    setDirty(true);
+}
+
 void UIListBox::setItems(const std::vector<ListBoxItem>& items) {
     _items = items;
+    _textCache.assign(_items.size(), ItemTextCache());
     _selectedIndex = -1;
     _topItemIndex = 0;
     setDirty(true);
@@ -15,16 +35,19 @@ void UIListBox::setItems(const std::vector<ListBoxItem>& items) {
 
 void UIListBox::addItem(const ListBoxItem& item) {
     _items.push_back(item);
+    _textCache.emplace_back();
     setDirty(true);
 }
 
 void UIListBox::addItem(const String& text, const uint8_t* mac) {
     _items.emplace_back(text, mac);
+    _textCache.emplace_back();
     setDirty(true);
 }
 
 void UIListBox::addItems(const std::vector<ListBoxItem>& items) {
     _items.insert(_items.end(), items.begin(), items.end());
+    _textCache.resize(_items.size());
     setDirty(true);
 }
 
@@ -34,6 +57,7 @@ bool UIListBox::removeItem(int index) {
     }
 
     _items.erase(_items.begin() + index);
+    _textCache.erase(_textCache.begin() + index);
 
     // Ajuster l'index sélectionné si l'élément supprimé l'affecte
     if (_selectedIndex == index) {
@@ -101,62 +125,238 @@ void UIListBox::onSelectionChanged(std::function<void(int, const ListBoxItem&)>
     _onSelectionChangedCallback = callback;
 }
 
-void UIListBox::drawInternal(TFT_eSPI& tft, bool force) {
-    // 1. Dessiner la bordure extérieure
-    tft.drawRect(rect.x, rect.y, rect.w, rect.h, _style.borderColor);
+void UIListBox::updateFontMetrics() {
+    if (_fontMetricsValid) return;
 
-    // 2. Dessiner le fond général (à l'intérieur de la bordure pour ne pas l'écraser)
-    tft.fillRect(rect.x + 1, rect.y + 1, rect.w - 2, rect.h - 2, _style.bgColor);
+    int16_t textH = _u8f.getFontAscent() - _u8f.getFontDescent();
+    _textBaselineOffset = (_style.itemHeight + textH) / 2;
+    _ellipsisWidth = _u8f.getUTF8Width("...");
+    _fontMetricsValid = true;
+}
 
-    // 3. Configurer la police pour être transparente
+void UIListBox::updateTextCache(int index, int16_t maxWidth) {
+    ItemTextCache& cache = _textCache[index];
+    if (cache.width >= 0) return; // Déjà calculé pour cette largeur
+
+    const String& text = _items[index].text;
+    cache.width = _u8f.getUTF8Width(text.c_str());
+    cache.truncated = cache.width > maxWidth;
+    cache.displayText = "";
+    if (!cache.truncated || maxWidth < _ellipsisWidth) return;
+
+    // Ne jamais couper au milieu d'une séquence UTF-8 multi-octets
+    int len = text.length();
+    auto isCharBoundary = [&text, len](int pos) {
+        return pos <= 0 || pos >= len || ((uint8_t)text[pos] & 0xC0) != 0x80;
+    };
+
+    // Recherche dichotomique du plus long préfixe qui, suivi de "...", tient dans maxWidth.
+    // Invariant : le préfixe de longueur 'fit' tient, celui de longueur 'noFit' ne tient pas.
+    int fit = 0;
+    int noFit = len;
+    while (true) {
+        int mid = (fit + noFit) / 2;
+        while (mid > fit && !isCharBoundary(mid)) mid--;
+        if (mid == fit) {
+            mid = (fit + noFit) / 2 + 1;
+            while (mid < noFit && !isCharBoundary(mid)) mid++;
+        }
+        if (mid >= noFit) break;
+
+        String candidate = text.substring(0, mid) + "...";
+        if (_u8f.getUTF8Width(candidate.c_str()) <= maxWidth) {
+            fit = mid;
+        } else {
+            noFit = mid;
+        }
+    }
+
+    cache.displayText = text.substring(0, fit) + "...";
+}
+
+void UIListBox::prepareFont() {
+    // Configurer la police pour être transparente
     _u8f.setFontMode(1);
     _u8f.setFont(_style.font);
+    updateFontMetrics();
+}
+
+void UIListBox::beginPaint(TFT_eSPI& tft) {
+    _hasScrollBar = _items.size() > _visibleItemCount;
+    int contentRight = _hasScrollBar ? rect.x + rect.w - 8 : rect.x + rect.w - 1;
+    _rowWidth = contentRight - (rect.x + 1);
+
+    // 1. Dessiner la bordure extérieure
+    tft.drawRect(rect.x, rect.y, rect.w, rect.h, _style.borderColor);
+
+    // 2. Le fond est dessiné ligne par ligne ; seule la zone sous la dernière ligne est remplie ici
+    int rowsBottom = rect.y + 1 + _visibleItemCount * _style.itemHeight;
+    int remainingH = rect.y + rect.h - 1 - rowsBottom;
+    if (remainingH > 0) {
+        tft.fillRect(rect.x + 1, rowsBottom, _rowWidth, remainingH, _style.bgColor);
+    }
+
+    // Zone de texte : marge de 5px à gauche, 1px avant la barre de défilement (ou la bordure)
+    int16_t textMaxWidth = contentRight - 1 - (rect.x + 5);
+    if (_textCacheMaxWidth != textMaxWidth) {
+        // La largeur disponible a changé (apparition de la barre, nouveau style) : invalider le cache
+        _textCache.assign(_items.size(), ItemTextCache());
+        _textCacheMaxWidth = textMaxWidth;
+    }
+}
+
+void UIListBox::drawRow(TFT_eSPI& tft, int row) {
+    int itemIndex = _topItemIndex + row;
+
+    // Calculer la position Y de l'item, en tenant compte de la bordure de 1px
+    int itemY = rect.y + 1 + row * _style.itemHeight;
+
+    // Fond de la ligne (mis en surbrillance si sélectionnée), sans empiéter sur la barre de défilement
+    // ni sur la bordure inférieure quand la dernière ligne touche le bas de la liste
+    int rowH = _style.itemHeight;
+    if (itemY + rowH > rect.y + rect.h - 1) {
+        rowH = rect.y + rect.h - 1 - itemY;
+    }
+    uint16_t rowBgColor = (itemIndex == _selectedIndex) ? _style.selectedBgColor : _style.bgColor;
+    tft.fillRect(rect.x + 1, itemY, _rowWidth, rowH, rowBgColor);
 
-    // 4. Dessiner les éléments visibles
+    if (itemIndex >= _items.size()) return; // Ligne vide sous le dernier élément
+
+    _u8f.setForegroundColor(itemIndex == _selectedIndex ? _style.selectedTextColor : _style.textColor);
+
+    // Dessiner le texte, tronqué avec "..." s'il dépasse la zone disponible
+    updateTextCache(itemIndex, _textCacheMaxWidth);
+    const ItemTextCache& cache = _textCache[itemIndex];
+    _u8f.setCursor(rect.x + 5, itemY + _textBaselineOffset); // Marge de 5px à gauche
+    if (!cache.truncated) {
+        _u8f.print(_items[itemIndex].text); // Utiliser le membre 'text' de ListBoxItem
+    } else if (cache.displayText.length() > 0) {
+        _u8f.print(cache.displayText);
+    }
+}
+
+void UIListBox::drawScrollBar(TFT_eSPI& tft) {
+    if (!_hasScrollBar) return;
+
+    int scrollBarX = rect.x + rect.w - 8;
+    // Le fond de la barre de scroll doit aussi être dans la bordure
+    tft.fillRect(scrollBarX, rect.y + 1, 7, rect.h - 2, _style.bgColor);
+
+    float thumbHeight = (float)_visibleItemCount / _items.size() * (rect.h - 2);
+    float thumbY = rect.y + 1 + ((float)_topItemIndex / _items.size() * (rect.h - 2));
+    
+    tft.fillRect(scrollBarX, (int)thumbY, 7, (int)thumbHeight, _style.scrollBarColor);
+}
+
+void UIListBox::drawInternal(TFT_eSPI& tft, bool force) {
+    // Un dessin complet remplace tout passage découpé en cours
+    _paintInProgress = false;
+
+    beginPaint(tft);
+    prepareFont();
     for (int i = 0; i < _visibleItemCount; ++i) {
-        int itemIndex = _topItemIndex + i;
-        if (itemIndex >= _items.size()) break;
+        drawRow(tft, i);
+    }
+    drawScrollBar(tft);
+}
 
-        // Calculer la position Y de l'item, en tenant compte de la bordure de 1px
-        int itemY = rect.y + 1 + i * _style.itemHeight;
+void UIListBox::setFrameRate(uint8_t fps) {
+    _frameIntervalMs = (fps > 0) ? 1000 / fps : 0;
+}
 
-        // Mettre en surbrillance l'élément sélectionné
-        if (itemIndex == _selectedIndex) {
-            tft.fillRect(rect.x + 1, itemY, rect.w - 2, _style.itemHeight, _style.selectedBgColor);
-            _u8f.setForegroundColor(_style.selectedTextColor);
-        } else {
-            _u8f.setForegroundColor(_style.textColor);
+void UIListBox::setFrameBudget(uint32_t budgetUs) {
+    _frameBudgetUs = budgetUs;
+}
+
+uint32_t UIListBox::getMissedDeadlines() const {
+    return _missedDeadlines;
+}
+
+void UIListBox::onDeadlineMissed(std::function<void(uint32_t)> callback) {
+    _onDeadlineMissedCallback = callback;
+}
+
+bool UIListBox::service(TFT_eSPI& tft) {
+    // 1. Fusionner les glissements reçus depuis la dernière image
+    applyPendingDrag();
+
+    if (!_paintInProgress && !isDirty()) {
+        return false;
+    }
+
+    // 2. Limiter la fréquence d'images
+    unsigned long nowMs = millis();
+    if (_frameIntervalMs > 0 && nowMs - _lastFrameMs < _frameIntervalMs) {
+        return false;
+    }
+    _lastFrameMs = nowMs;
+
+    unsigned long frameStartUs = micros();
+
+    // 3. Prendre en compte un changement d'état, y compris pendant un passage découpé.
+    // Le passage n'est pas renvoyé à la ligne 0 (il n'aboutirait jamais pendant un glissement
+    // continu) : il reprend à _nextPaintRow avec le nouvel état et fait le tour des lignes visibles.
+    // La barre de défilement, peu coûteuse, reflète immédiatement la nouvelle position.
+    if (isDirty()) {
+        setDirty(false);
+        // Le nombre de lignes visibles peut avoir diminué (setStyle()) depuis le début du passage
+        if (!_paintInProgress || _nextPaintRow >= _visibleItemCount) {
+            _nextPaintRow = 0;
+        }
+        _paintInProgress = true;
+        _rowsToPaint = _visibleItemCount;
+        beginPaint(tft);
+        drawScrollBar(tft);
+    }
+    prepareFont(); // _u8f peut avoir été reconfiguré par un autre composant depuis la dernière tranche
+
+    // 4. Dessiner autant de lignes que le budget le permet (au moins une pour toujours progresser)
+    int rowsDrawn = 0;
+    while (_rowsToPaint > 0) {
+        uint32_t elapsedUs = micros() - frameStartUs;
+        if (_frameBudgetUs > 0 && rowsDrawn > 0 && elapsedUs + _rowCostUs > _frameBudgetUs) {
+            break;
         }
 
-        // Dessiner le texte
-        int16_t textH = _u8f.getFontAscent() - _u8f.getFontDescent();
-        int textY_baseline = itemY + (_style.itemHeight + textH) / 2;
-        _u8f.setCursor(rect.x + 5, textY_baseline); // Marge de 5px à gauche
-        _u8f.print(_items[itemIndex].text); // Utiliser le membre 'text' de ListBoxItem
+        unsigned long rowStartUs = micros();
+        drawRow(tft, _nextPaintRow);
+        uint32_t rowCostUs = micros() - rowStartUs;
+        _rowCostUs = (_rowCostUs == 0) ? rowCostUs : (3 * _rowCostUs + rowCostUs) / 4;
+        _nextPaintRow = (_nextPaintRow + 1) % _visibleItemCount;
+        _rowsToPaint--;
+        rowsDrawn++;
     }
 
-    // 5. Dessiner la barre de défilement si nécessaire
-    if (_items.size() > _visibleItemCount) {
-        int scrollBarX = rect.x + rect.w - 8;
-        // Le fond de la barre de scroll doit aussi être dans la bordure
-        tft.fillRect(scrollBarX, rect.y + 1, 7, rect.h - 2, _style.bgColor);
+    if (_rowsToPaint <= 0) {
+        _paintInProgress = false; // Toutes les lignes visibles reflètent l'état courant
+    }
 
-        float thumbHeight = (float)_visibleItemCount / _items.size() * (rect.h - 2);
-        float thumbY = rect.y + 1 + ((float)_topItemIndex / _items.size() * (rect.h - 2));
-        
-        tft.fillRect(scrollBarX, (int)thumbY, 7, (int)thumbHeight, _style.scrollBarColor);
+    // 5. Signaler les images qui ont dépassé leur budget (ou, à défaut, la période d'image)
+    uint32_t frameUs = micros() - frameStartUs;
+    uint32_t deadlineUs = (_frameBudgetUs > 0) ? _frameBudgetUs : _frameIntervalMs * 1000;
+    if (deadlineUs > 0 && frameUs > deadlineUs) {
+        _missedDeadlines++;
+        if (_onDeadlineMissedCallback) {
+            _onDeadlineMissedCallback(frameUs);
+        }
     }
+
+    return true;
 }
 
 void UIListBox::handlePress(TFT_eSPI& tft, int tx, int ty) {
     if (enabled && contains(tx, ty)) {
         _isDragging = true;
+        _hasPendingDrag = false;
         _dragStartY = ty;
         _dragStartTopIndex = _topItemIndex;
     }
 }
 
 void UIListBox::handleRelease(TFT_eSPI& tft, int tx, int ty) {
+    // Appliquer la dernière position avant de tester le clic
+    applyPendingDrag();
+
     if (enabled && _isDragging) {
         // Si ce n'était pas un drag, c'est un clic pour sélectionner
         if (abs(ty - _dragStartY) < _style.itemHeight / 2) {
@@ -169,31 +369,44 @@ void UIListBox::handleRelease(TFT_eSPI& tft, int tx, int ty) {
 
 void UIListBox::handleDrag(TFT_eSPI& tft, int tx, int ty) {
     if (enabled && _isDragging) {
-        // Calculer la distance de glissement depuis le point de départ
-        int dragDistance = ty - _dragStartY;
+        // Mémoriser seulement la dernière position ; service() l'appliquera une fois par image
+        _pendingDragY = ty;
+        _hasPendingDrag = true;
 
-        // Calculer le décalage en nombre d'items.
-        // Le signe est inversé pour un défilement "naturel" (glisser vers le bas fait monter le contenu)
-        int itemScrolled = -dragDistance / (int)_style.itemHeight;
+        if (_frameIntervalMs == 0) {
+            applyPendingDrag(); // Pas de limite de fréquence : comportement immédiat
+        }
+    }
+}
 
-        int newTopIndex = _dragStartTopIndex + itemScrolled;
+void UIListBox::applyPendingDrag() {
+    if (!_hasPendingDrag) return;
+    _hasPendingDrag = false;
 
-        // Brider l'index pour qu'il reste dans les limites valides
-        int maxTopIndex = _items.size() - _visibleItemCount;
-        if (maxTopIndex < 0) {
-            maxTopIndex = 0;
-        }
+    // Calculer la distance de glissement depuis le point de départ
+    int dragDistance = _pendingDragY - _dragStartY;
 
-        if (newTopIndex < 0) {
-            newTopIndex = 0;
-        } else if (newTopIndex > maxTopIndex) {
-            newTopIndex = maxTopIndex;
-        }
+    // Calculer le décalage en nombre d'items.
+    // Le signe est inversé pour un défilement "naturel" (glisser vers le bas fait monter le contenu)
+    int itemScrolled = -dragDistance / (int)_style.itemHeight;
 
-        // Si l'index a changé, marquer pour redessiner
-        if (_topItemIndex != newTopIndex) {
-            _topItemIndex = newTopIndex;
-            setDirty(true);
-        }
+    int newTopIndex = _dragStartTopIndex + itemScrolled;
+
+    // Brider l'index pour qu'il reste dans les limites valides
+    int maxTopIndex = _items.size() - _visibleItemCount;
+    if (maxTopIndex < 0) {
+        maxTopIndex = 0;
+    }
+
+    if (newTopIndex < 0) {
+        newTopIndex = 0;
+    } else if (newTopIndex > maxTopIndex) {
+        newTopIndex = maxTopIndex;
+    }
+
+    // Si l'index a changé, marquer pour redessiner
+    if (_topItemIndex != newTopIndex) {
+        _topItemIndex = newTopIndex;
+        setDirty(true);
     }
 }
\ No newline at end of file
@@ -70,6 +70,15 @@ public:
      */
     UIListBox(U8g2_for_TFT_eSPI& u8f, const UIRect& rect, const UIListBoxStyle& style);
 
+    /**
+     * @brief Remplace le style visuel de la liste.
+     * 
+     * Les métriques de police et les largeurs de texte mises en cache sont recalculées au prochain dessin.
+     * 
+     * @param style Le nouveau style à appliquer.
+     */
+    void setStyle(const UIListBoxStyle& style);
+
     // Gestion des éléments
     /**
      * @brief Définit les éléments à afficher dans la liste.
@@ -160,6 +169,50 @@ public:
      */
     void onSelectionChanged(std::function<void(int, const ListBoxItem&)> callback);
 
+    // Planification du rendu
+    /**
+     * @brief Limite la fréquence de rafraîchissement appliquée par service().
+     * 
+     * @param fps Nombre maximal d'images par seconde. Mettre 0 pour ne pas limiter.
+     *            Quand une limite est active, handleDrag() ne fait que mémoriser la dernière position.
+     */
+    void setFrameRate(uint8_t fps);
+
+    /**
+     * @brief Définit le budget de temps alloué au dessin de la liste à chaque image.
+     * 
+     * Si un redessin complet dépasse ce budget, service() le répartit sur plusieurs images par tranches de lignes.
+     * 
+     * @param budgetUs Budget en microsecondes. Mettre 0 pour toujours tout redessiner en une fois.
+     */
+    void setFrameBudget(uint32_t budgetUs);
+
+    /**
+     * @brief Applique les événements tactiles en attente et redessine si une image est due.
+     * 
+     * À appeler à chaque itération de loop() à la place de draw(). Les positions de glissement
+     * intermédiaires sont fusionnées, le rafraîchissement est limité par setFrameRate() et
+     * découpé selon setFrameBudget().
+     * 
+     * @param tft Référence à l'objet TFT_eSPI.
+     * @return true si quelque chose a été dessiné pendant cet appel.
+     */
+    bool service(TFT_eSPI& tft);
+
+    /**
+     * @brief Obtient le nombre d'images dont le dessin a dépassé son budget.
+     * 
+     * @return uint32_t Le nombre d'échéances manquées depuis la création de la liste.
+     */
+    uint32_t getMissedDeadlines() const;
+
+    /**
+     * @brief Définit une fonction de rappel appelée lorsqu'une image dépasse son budget.
+     * 
+     * @param callback La fonction à appeler. Elle reçoit la durée de dessin mesurée en microsecondes.
+     */
+    void onDeadlineMissed(std::function<void(uint32_t)> callback);
+
     // Surcharge des méthodes de UIComponent pour la gestion du tactile
     void handlePress(TFT_eSPI& tft, int tx, int ty) override;
     void handleRelease(TFT_eSPI& tft, int tx, int ty) override;
@@ -173,18 +226,93 @@ private:
      */
     void drawInternal(TFT_eSPI& tft, bool force) override;
 
+    /**
+     * @brief Démarre un passage de dessin : bordure, zone sous les lignes et validation des caches.
+     * @param tft Référence à l'objet TFT_eSPI.
+     */
+    void beginPaint(TFT_eSPI& tft);
+
+    /**
+     * @brief Active la police du style sur _u8f (partagé avec d'autres composants).
+     */
+    void prepareFont();
+
+    /**
+     * @brief Dessine une ligne visible (fond et texte), qu'elle contienne un élément ou non.
+     * @param tft Référence à l'objet TFT_eSPI.
+     * @param row Index de la ligne visible (0 pour la première).
+     */
+    void drawRow(TFT_eSPI& tft, int row);
+
+    /**
+     * @brief Dessine la piste et le curseur de la barre de défilement si nécessaire.
+     * @param tft Référence à l'objet TFT_eSPI.
+     */
+    void drawScrollBar(TFT_eSPI& tft);
+
+    /**
+     * @brief Applique la dernière position de glissement mémorisée par handleDrag().
+     */
+    void applyPendingDrag();
+
+    /**
+     * @brief Calcule les métriques de la police courante si le style a changé.
+     * La police du style doit déjà être active sur _u8f.
+     */
+    void updateFontMetrics();
+
+    /**
+     * @brief Calcule (si nécessaire) la largeur et le point de troncature d'un élément.
+     * @param index L'index de l'élément.
+     * @param maxWidth Largeur disponible pour le texte en pixels.
+     */
+    void updateTextCache(int index, int16_t maxWidth);
+
+    /**
+     * @brief Données de rendu mises en cache pour un élément de la liste.
+     */
+    struct ItemTextCache {
+        int16_t width = -1;         ///< Largeur du texte complet en pixels (-1 si non calculée).
+        bool truncated = false;     ///< Vrai si le texte dépasse la largeur disponible.
+        String displayText;         ///< Texte tronqué suivi de "..." (utilisé seulement si truncated).
+    };
+
     UIListBoxStyle _style;                      ///< Style visuel de la liste.
     std::vector<ListBoxItem> _items;            ///< Conteneur pour les éléments de la liste.
     int _selectedIndex = -1;                    ///< Index de l'élément actuellement sélectionné.
     int _topItemIndex = 0;                      ///< Index du premier élément visible (pour le défilement).
     int _visibleItemCount = 0;                  ///< Nombre d'éléments visibles à l'écran.
 
+    // Cache des métriques de police et des largeurs de texte
+    bool _fontMetricsValid = false;             ///< Faux tant que les métriques du style courant n'ont pas été calculées.
+    int16_t _textBaselineOffset = 0;            ///< Décalage vertical de la ligne de base du texte dans un élément.
+    int16_t _ellipsisWidth = 0;                 ///< Largeur en pixels de la chaîne "...".
+    int16_t _textCacheMaxWidth = -1;            ///< Largeur disponible pour laquelle _textCache a été calculé.
+    std::vector<ItemTextCache> _textCache;      ///< Cache de rendu, un par élément (parallèle à _items).
+
+    // Géométrie calculée au début de chaque passage de dessin
+    bool _hasScrollBar = false;                 ///< Vrai si la barre de défilement est affichée.
+    int _rowWidth = 0;                          ///< Largeur du fond d'une ligne (jusqu'à la barre ou la bordure).
+
     std::function<void(int, const ListBoxItem&)> _onSelectionChangedCallback; ///< Pointeur de fonction pour le callback de sélection.
 
     // Variables pour la gestion du défilement par glissement
     bool _isDragging = false;                   ///< Vrai si un glissement est en cours.
     int _dragStartY = 0;                        ///< Position Y de départ du glissement.
     int _dragStartTopIndex = 0;                 ///< Index de l'élément supérieur au début du glissement.
+    bool _hasPendingDrag = false;               ///< Vrai si une position de glissement attend d'être appliquée.
+    int _pendingDragY = 0;                      ///< Dernière position Y de glissement reçue.
+
+    // Variables pour la planification du rendu
+    uint32_t _frameIntervalMs = 0;              ///< Intervalle minimal entre deux images (0 = illimité).
+    uint32_t _frameBudgetUs = 0;                ///< Budget de dessin par image (0 = pas de découpage).
+    unsigned long _lastFrameMs = 0;             ///< Instant (millis) de la dernière image dessinée par service().
+    bool _paintInProgress = false;              ///< Vrai si un redessin découpé est en cours.
+    int _nextPaintRow = 0;                      ///< Prochaine ligne visible à dessiner dans le passage en cours.
+    int _rowsToPaint = 0;                       ///< Lignes restant à dessiner depuis le dernier changement d'état.
+    uint32_t _rowCostUs = 0;                    ///< Moyenne glissante du temps de dessin d'une ligne.
+    uint32_t _missedDeadlines = 0;              ///< Nombre d'images ayant dépassé leur budget.
+    std::function<void(uint32_t)> _onDeadlineMissedCallback; ///< Callback appelé en cas de dépassement.
 };
 
 #endif // UILISTBOX_H
\ No newline at end of file